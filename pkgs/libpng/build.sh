@@ -15,6 +15,7 @@ build() {
         CCFLAGS="-I$opt_toolsdir/include -DPNG_NO_CONSOLE_IO" \
         LDFLAGS="-L$opt_toolsdir/lib" \
             ./configure --host=$opt_arch --prefix="$opt_toolsdir" --enable-shared=no \
+                --enable-intel-sse=yes \
                 --enable-arm-neon=no \
                 --enable-mips-msa=no \
                 --enable-powerpc-vsx=no && \
@@ -0,0 +1,240 @@
+#include <stdint.h>
+#include <stdlib.h>
+#include <cpuid.h>
+#include <immintrin.h>
+
+/*
+ * Pixel kernels of the painter. Every kernel has a scalar reference, an
+ * SSE2 version (the x86_64 baseline) and an AVX2 version which is only
+ * used if the processor supports it and the system saves the YMM
+ * registers. Pixels are 32-bit BGRA words.
+ */
+
+enum {
+  SIMD_SCALAR = 0,
+  SIMD_SSE2 = 1,
+  SIMD_AVX2 = 2,
+};
+
+static int simd_level = -1;
+
+static int detect_simd_level(void) {
+  unsigned int a, b, c, d;
+  if (!__get_cpuid(1, &a, &b, &c, &d))
+    return SIMD_SSE2;
+  /* the system must have enabled saving the YMM registers */
+  if (!(c & bit_OSXSAVE) || !(c & bit_AVX))
+    return SIMD_SSE2;
+  unsigned int xcr0_lo, xcr0_hi;
+  __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+  if ((xcr0_lo & 0x6) != 0x6)
+    return SIMD_SSE2;
+  if (!__get_cpuid_count(7, 0, &a, &b, &c, &d) || !(b & bit_AVX2))
+    return SIMD_SSE2;
+  return SIMD_AVX2;
+}
+
+int painter_simd_level(void) {
+  if (simd_level < 0)
+    simd_level = detect_simd_level();
+  return simd_level;
+}
+
+/* forces a level, at most the one the processor supports, returns the level used */
+int painter_set_simd_level(int level) {
+  int max = detect_simd_level();
+  simd_level = level > max ? max : level;
+  return simd_level;
+}
+
+/* alpha blending, dst = src * a + dst * (0xff - a), the alpha of dst is kept */
+
+void alpha_blend_scalar(unsigned char * restrict dst, const unsigned char * restrict src, size_t size) {
+  unsigned char *rdd = dst;
+  const unsigned char *rds = src;
+  for (size_t i = 0; i < size; i += 4) {
+      unsigned char db = rdd[i + 0], dg = rdd[i + 1], dr = rdd[i + 2];
+      const unsigned char sb = rds[i + 0], sg = rds[i + 1], sr = rds[i + 2], sa = rds[i + 3], saf = 0xff - sa;
+      rdd[i + 0] = (((uint16_t)sb * sa) >> 8) + (((uint16_t)db * saf) >> 8) + 1;
+      rdd[i + 1] = (((uint16_t)sg * sa) >> 8) + (((uint16_t)dg * saf) >> 8) + 1;
+      rdd[i + 2] = (((uint16_t)sr * sa) >> 8) + (((uint16_t)dr * saf) >> 8) + 1;
+  }
+}
+
+/* blends 2 pixels widened to 16 bits, the same way as the scalar version */
+static inline __m128i blend_u16_sse2(__m128i d, __m128i s) {
+  const __m128i ff = _mm_set1_epi16(0xff);
+  const __m128i one = _mm_set1_epi16(1);
+  __m128i a = _mm_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3));
+  a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+  __m128i af = _mm_sub_epi16(ff, a);
+  __m128i t = _mm_srli_epi16(_mm_mullo_epi16(s, a), 8);
+  __m128i u = _mm_srli_epi16(_mm_mullo_epi16(d, af), 8);
+  return _mm_add_epi16(_mm_add_epi16(t, u), one);
+}
+
+static void alpha_blend_sse2(unsigned char * restrict dst, const unsigned char * restrict src, size_t size) {
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i amask = _mm_set1_epi32(0xff000000);
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+    __m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+    __m128i lo = blend_u16_sse2(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(s, zero));
+    __m128i hi = blend_u16_sse2(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(s, zero));
+    __m128i r = _mm_packus_epi16(lo, hi);
+    r = _mm_or_si128(_mm_andnot_si128(amask, r), _mm_and_si128(amask, d));
+    _mm_storeu_si128((__m128i *)(dst + i), r);
+  }
+  alpha_blend_scalar(dst + i, src + i, size - i);
+}
+
+__attribute__((target("avx2")))
+static inline __m256i blend_u16_avx2(__m256i d, __m256i s) {
+  const __m256i ff = _mm256_set1_epi16(0xff);
+  const __m256i one = _mm256_set1_epi16(1);
+  __m256i a = _mm256_shufflelo_epi16(s, _MM_SHUFFLE(3, 3, 3, 3));
+  a = _mm256_shufflehi_epi16(a, _MM_SHUFFLE(3, 3, 3, 3));
+  __m256i af = _mm256_sub_epi16(ff, a);
+  __m256i t = _mm256_srli_epi16(_mm256_mullo_epi16(s, a), 8);
+  __m256i u = _mm256_srli_epi16(_mm256_mullo_epi16(d, af), 8);
+  return _mm256_add_epi16(_mm256_add_epi16(t, u), one);
+}
+
+__attribute__((target("avx2")))
+static void alpha_blend_avx2(unsigned char * restrict dst, const unsigned char * restrict src, size_t size) {
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i amask = _mm256_set1_epi32(0xff000000);
+  size_t i = 0;
+  /* unpacking and packing work within 128-bit lanes, so pixels stay in order */
+  for (; i + 32 <= size; i += 32) {
+    __m256i d = _mm256_loadu_si256((const __m256i *)(dst + i));
+    __m256i s = _mm256_loadu_si256((const __m256i *)(src + i));
+    __m256i lo = blend_u16_avx2(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(s, zero));
+    __m256i hi = blend_u16_avx2(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(s, zero));
+    __m256i r = _mm256_packus_epi16(lo, hi);
+    r = _mm256_or_si256(_mm256_andnot_si256(amask, r), _mm256_and_si256(amask, d));
+    _mm256_storeu_si256((__m256i *)(dst + i), r);
+  }
+  _mm256_zeroupper();
+  alpha_blend_sse2(dst + i, src + i, size - i);
+}
+
+void alpha_blend(unsigned char * restrict dst, const unsigned char * restrict src, size_t size) {
+  switch (painter_simd_level()) {
+  case SIMD_AVX2:
+    alpha_blend_avx2(dst, src, size);
+    break;
+  case SIMD_SSE2:
+    alpha_blend_sse2(dst, src, size);
+    break;
+  default:
+    alpha_blend_scalar(dst, src, size);
+  }
+}
+
+/* solid fill of n pixels */
+
+void fill_u32_scalar(uint32_t *dst, uint32_t color, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    dst[i] = color;
+}
+
+static void fill_u32_sse2(uint32_t *dst, uint32_t color, size_t n) {
+  const __m128i c = _mm_set1_epi32(color);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    _mm_storeu_si128((__m128i *)(dst + i), c);
+    _mm_storeu_si128((__m128i *)(dst + i + 4), c);
+    _mm_storeu_si128((__m128i *)(dst + i + 8), c);
+    _mm_storeu_si128((__m128i *)(dst + i + 12), c);
+  }
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_si128((__m128i *)(dst + i), c);
+  fill_u32_scalar(dst + i, color, n - i);
+}
+
+__attribute__((target("avx2")))
+static void fill_u32_avx2(uint32_t *dst, uint32_t color, size_t n) {
+  const __m256i c = _mm256_set1_epi32(color);
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    _mm256_storeu_si256((__m256i *)(dst + i), c);
+    _mm256_storeu_si256((__m256i *)(dst + i + 8), c);
+    _mm256_storeu_si256((__m256i *)(dst + i + 16), c);
+    _mm256_storeu_si256((__m256i *)(dst + i + 24), c);
+  }
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_si256((__m256i *)(dst + i), c);
+  _mm256_zeroupper();
+  fill_u32_scalar(dst + i, color, n - i);
+}
+
+void fill_u32(uint32_t *dst, uint32_t color, size_t n) {
+  switch (painter_simd_level()) {
+  case SIMD_AVX2:
+    fill_u32_avx2(dst, color, n);
+    break;
+  case SIMD_SSE2:
+    fill_u32_sse2(dst, color, n);
+    break;
+  default:
+    fill_u32_scalar(dst, color, n);
+  }
+}
+
+/* copy of n pixels, the buffers don't overlap */
+
+void copy_u32_scalar(uint32_t * restrict dst, const uint32_t * restrict src, size_t n) {
+  for (size_t i = 0; i < n; i++)
+    dst[i] = src[i];
+}
+
+static void copy_u32_sse2(uint32_t * restrict dst, const uint32_t * restrict src, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+    __m128i b = _mm_loadu_si128((const __m128i *)(src + i + 4));
+    __m128i c = _mm_loadu_si128((const __m128i *)(src + i + 8));
+    __m128i d = _mm_loadu_si128((const __m128i *)(src + i + 12));
+    _mm_storeu_si128((__m128i *)(dst + i), a);
+    _mm_storeu_si128((__m128i *)(dst + i + 4), b);
+    _mm_storeu_si128((__m128i *)(dst + i + 8), c);
+    _mm_storeu_si128((__m128i *)(dst + i + 12), d);
+  }
+  for (; i + 4 <= n; i += 4)
+    _mm_storeu_si128((__m128i *)(dst + i), _mm_loadu_si128((const __m128i *)(src + i)));
+  copy_u32_scalar(dst + i, src + i, n - i);
+}
+
+__attribute__((target("avx2")))
+static void copy_u32_avx2(uint32_t * restrict dst, const uint32_t * restrict src, size_t n) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i a = _mm256_loadu_si256((const __m256i *)(src + i));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(src + i + 8));
+    __m256i c = _mm256_loadu_si256((const __m256i *)(src + i + 16));
+    __m256i d = _mm256_loadu_si256((const __m256i *)(src + i + 24));
+    _mm256_storeu_si256((__m256i *)(dst + i), a);
+    _mm256_storeu_si256((__m256i *)(dst + i + 8), b);
+    _mm256_storeu_si256((__m256i *)(dst + i + 16), c);
+    _mm256_storeu_si256((__m256i *)(dst + i + 24), d);
+  }
+  for (; i + 8 <= n; i += 8)
+    _mm256_storeu_si256((__m256i *)(dst + i), _mm256_loadu_si256((const __m256i *)(src + i)));
+  _mm256_zeroupper();
+  copy_u32_scalar(dst + i, src + i, n - i);
+}
+
+void copy_u32(uint32_t * restrict dst, const uint32_t * restrict src, size_t n) {
+  switch (painter_simd_level()) {
+  case SIMD_AVX2:
+    copy_u32_avx2(dst, src, n);
+    break;
+  case SIMD_SSE2:
+    copy_u32_sse2(dst, src, n);
+    break;
+  default:
+    copy_u32_scalar(dst, src, n);
+  }
+}
@@ -8,6 +8,7 @@ int mkppipe(const char *path, unsigned int flags, pid_t pid);
 
 #define PIPE_CONF_FLAGS  6
 #define PIPE_CONF_PID    7
+#define PIPE_CONF_CAPACITY 8
 #define PIPE_WAIT_READ  (1 << 0)
 
 #define PIPE_M_RD  (1 << 1)
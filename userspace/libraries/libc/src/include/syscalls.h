@@ -11,10 +11,12 @@ int close(int fd);
 ssize_t write(int fd, const void *str, size_t len);
 ssize_t read(int fd, void *str, size_t len);
 int ftruncate(int fd, off_t length);
+int fsync(int fd);
 int _ioctl(int fd, int request, unsigned long arg);
 int waitfd(int *fds, size_t nfds, useconds_t timeout);
 void *mmap(void *addr, size_t len, int prot, int flags,
            int fd, off_t off);
+#define MAP_HUGEPAGES (1 << 0)
 void munmap(void *addr, size_t len);
 int remove(char *device);
 void *sbrk(size_t size);
@@ -37,11 +39,28 @@ int usleep(useconds_t usec);
 
 pid_t waitpid(pid_t pid, int *status, int options);
 
+#define PRIORITY_HIGH   0
+#define PRIORITY_NORMAL 1
+#define PRIORITY_LOW    2
+#define PRIORITY_IDLE   3
+int _setpriority(pid_t pid, int priority);
+
 char *getcwd(char *buf, size_t length);
 int chdir(char *buf);
 
 off_t lseek(int fd, off_t offset, int whence);
 
+/* batched io: operations are queued with io_ring_*, submitted with
+   io_ring_enter and their results collected with io_ring_complete */
+int io_ring_setup();
+int io_ring_read(int fd, void *str, size_t len, unsigned long user_data);
+int io_ring_write(int fd, const void *str, size_t len, unsigned long user_data);
+int io_ring_open(char *device, int flags, unsigned long user_data);
+int io_ring_seek(int fd, int offset, int whence, unsigned long user_data);
+int io_ring_waitfd(int *fds, size_t nfds, unsigned long user_data);
+int io_ring_enter(int min_complete);
+int io_ring_complete(unsigned long *user_data, long *result);
+
 #define PATH_MAX 4096
 #define FILENAME_MAX 256
 